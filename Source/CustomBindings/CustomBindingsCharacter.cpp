@@ -3,6 +3,14 @@
 #include "CustomBindings.h"
 #include "Kismet/HeadMountedDisplayFunctionLibrary.h"
 #include "CustomBindingsCharacter.h"
+#include "CustomBindingsMovementBatch.h"
+
+static TAutoConsoleVariable<int32> CVarBatchedMovementInput(
+	TEXT("CustomBindings.BatchedMovementInput"),
+	1,
+	TEXT("0: each character turns its MoveForward/MoveRight input into movement on its own\n")
+	TEXT("1: movement input of all characters is resolved once per frame by the movement batch\n")
+	TEXT("Applies to characters that begin play afterwards"));
 
 //////////////////////////////////////////////////////////////////////////
 // ACustomBindingsCharacter
@@ -16,6 +24,10 @@ ACustomBindingsCharacter::ACustomBindingsCharacter()
 	BaseTurnRate = 45.f;
 	BaseLookUpRate = 45.f;
 
+	MovementBatch = NULL;
+	PendingMoveForward = 0.0f;
+	PendingMoveRight = 0.0f;
+
 	// Don't rotate when the controller rotates. Let that just affect the camera.
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationYaw = false;
@@ -71,6 +83,74 @@ void ACustomBindingsCharacter::SetupPlayerInputComponent(class UInputComponent*
 	PlayerInputComponent->BindAction("ResetVR", IE_Pressed, this, &ACustomBindingsCharacter::OnResetVR);
 }
 
+void ACustomBindingsCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// characters that begin play with batching off keep the per character path for their whole life
+	if (CVarBatchedMovementInput.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	MovementBatch = ACustomBindingsMovementBatch::Get(GetWorld());
+	if (MovementBatch != NULL)
+	{
+		MovementBatch->Register(this);
+	}
+}
+
+void ACustomBindingsCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (MovementBatch != NULL)
+	{
+		MovementBatch->Unregister(this);
+		MovementBatch = NULL;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ACustomBindingsCharacter::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	if (MovementBatch != NULL && NewController != NULL)
+	{
+		MovementBatch->AddInputSourcePrerequisite(NewController);
+	}
+}
+
+void ACustomBindingsCharacter::UnPossessed()
+{
+	if (MovementBatch != NULL && Controller != NULL)
+	{
+		MovementBatch->RemoveInputSourcePrerequisite(Controller);
+	}
+
+	Super::UnPossessed();
+}
+
+void ACustomBindingsCharacter::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+
+	// PossessedBy only runs on the server, clients learn their controller here or through replication
+	if (MovementBatch != NULL && Controller != NULL)
+	{
+		MovementBatch->AddInputSourcePrerequisite(Controller);
+	}
+}
+
+void ACustomBindingsCharacter::OnRep_Controller()
+{
+	Super::OnRep_Controller();
+
+	if (MovementBatch != NULL && Controller != NULL)
+	{
+		MovementBatch->AddInputSourcePrerequisite(Controller);
+	}
+}
 
 void ACustomBindingsCharacter::OnResetVR()
 {
@@ -99,10 +179,23 @@ void ACustomBindingsCharacter::LookUpAtRate(float Rate)
 	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds());
 }
 
+void ACustomBindingsCharacter::AddMovementIntent(float ForwardValue, float RightValue)
+{
+	MoveForward(ForwardValue);
+	MoveRight(RightValue);
+}
+
 void ACustomBindingsCharacter::MoveForward(float Value)
 {
 	if ((Controller != NULL) && (Value != 0.0f))
 	{
+		// let the movement batch find out which way is forward, together with every other character
+		if (MovementBatch != NULL)
+		{
+			PendingMoveForward += Value;
+			return;
+		}
+
 		// find out which way is forward
 		const FRotator Rotation = Controller->GetControlRotation();
 		const FRotator YawRotation(0, Rotation.Yaw, 0);
@@ -117,6 +210,12 @@ void ACustomBindingsCharacter::MoveRight(float Value)
 {
 	if ( (Controller != NULL) && (Value != 0.0f) )
 	{
+		if (MovementBatch != NULL)
+		{
+			PendingMoveRight += Value;
+			return;
+		}
+
 		// find out which way is right
 		const FRotator Rotation = Controller->GetControlRotation();
 		const FRotator YawRotation(0, Rotation.Yaw, 0);
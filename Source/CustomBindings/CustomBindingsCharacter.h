@@ -26,6 +26,22 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseLookUpRate;
 
+	/**
+	 * Feeds movement axis values through MoveForward/MoveRight, e.g. for AI driven characters.
+	 * Has to be called from a tick that runs before the movement batch, i.e. from the controller or
+	 * an actor registered with ACustomBindingsMovementBatch::AddInputSourcePrerequisite; otherwise the
+	 * batched input is applied a frame late.
+	 */
+	UFUNCTION(BlueprintCallable, Category=Movement)
+	void AddMovementIntent(float ForwardValue, float RightValue);
+
+	// APawn interface
+	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void PawnClientRestart() override;
+	virtual void OnRep_Controller() override;
+	// End of APawn interface
+
 protected:
 
 	/** Resets HMD orientation in VR. */
@@ -60,10 +76,26 @@ protected:
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	// End of APawn interface
 
+	// AActor interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of AActor interface
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+
+private:
+	friend class ACustomBindingsMovementBatch;
+
+	/** Movement intent stage of this world, resolving movement input for all characters at once */
+	UPROPERTY(Transient)
+	class ACustomBindingsMovementBatch* MovementBatch;
+
+	/** Axis values recorded this frame, consumed by the movement batch */
+	float PendingMoveForward;
+	float PendingMoveRight;
 };
 
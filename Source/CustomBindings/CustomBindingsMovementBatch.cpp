@@ -0,0 +1,119 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomBindings.h"
+#include "CustomBindingsMovementBatch.h"
+#include "CustomBindingsCharacter.h"
+#include "EngineUtils.h"
+
+ACustomBindingsMovementBatch::ACustomBindingsMovementBatch()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+}
+
+ACustomBindingsMovementBatch* ACustomBindingsMovementBatch::Get(UWorld* World)
+{
+	if (World == NULL)
+	{
+		return NULL;
+	}
+
+	for (TActorIterator<ACustomBindingsMovementBatch> It(World); It; ++It)
+	{
+		return *It;
+	}
+
+	return World->SpawnActor<ACustomBindingsMovementBatch>();
+}
+
+void ACustomBindingsMovementBatch::Register(ACustomBindingsCharacter* Character)
+{
+	Characters.AddUnique(Character);
+	SetActorTickEnabled(true);
+
+	// movement components consume the input vector, so they have to wait for the batch
+	Character->GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PrimaryActorTick);
+
+	if (Character->GetController() != NULL)
+	{
+		AddInputSourcePrerequisite(Character->GetController());
+	}
+}
+
+void ACustomBindingsMovementBatch::Unregister(ACustomBindingsCharacter* Character)
+{
+	Characters.RemoveSwap(Character);
+	if (Characters.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+
+	Character->GetCharacterMovement()->PrimaryComponentTick.RemovePrerequisite(this, PrimaryActorTick);
+
+	if (Character->GetController() != NULL)
+	{
+		RemoveInputSourcePrerequisite(Character->GetController());
+	}
+}
+
+void ACustomBindingsMovementBatch::AddInputSourcePrerequisite(AActor* InputSource)
+{
+	PrimaryActorTick.AddPrerequisite(InputSource, InputSource->PrimaryActorTick);
+}
+
+void ACustomBindingsMovementBatch::RemoveInputSourcePrerequisite(AActor* InputSource)
+{
+	PrimaryActorTick.RemovePrerequisite(InputSource, InputSource->PrimaryActorTick);
+}
+
+void ACustomBindingsMovementBatch::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// gather this frame's axis values and control yaw of every character that wants to move
+	Moving.Reset();
+	Yaw.Reset();
+	Forward.Reset();
+	Right.Reset();
+
+	for (ACustomBindingsCharacter* Character : Characters)
+	{
+		if (Character->PendingMoveForward == 0.0f && Character->PendingMoveRight == 0.0f)
+		{
+			continue;
+		}
+
+		if (AController* CharacterController = Character->GetController())
+		{
+			Moving.Add(Character);
+			Yaw.Add(CharacterController->GetControlRotation().Yaw);
+			Forward.Add(Character->PendingMoveForward);
+			Right.Add(Character->PendingMoveRight);
+		}
+
+		Character->PendingMoveForward = 0.0f;
+		Character->PendingMoveRight = 0.0f;
+	}
+
+	// one yaw basis per controller, instead of a rotation matrix per axis; a flat loop over packed floats
+	const int32 NumMoving = Moving.Num();
+	DirectionX.SetNumUninitialized(NumMoving, false);
+	DirectionY.SetNumUninitialized(NumMoving, false);
+
+	for (int32 Index = 0; Index < NumMoving; Index++)
+	{
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Yaw[Index]));
+
+		// forward is (Cos, Sin, 0) and right is (-Sin, Cos, 0), same as the yaw-only rotation matrix axes
+		DirectionX[Index] = Cos * Forward[Index] - Sin * Right[Index];
+		DirectionY[Index] = Sin * Forward[Index] + Cos * Right[Index];
+	}
+
+	// input vectors add up, so one call carries both axes
+	for (int32 Index = 0; Index < NumMoving; Index++)
+	{
+		Moving[Index]->AddMovementInput(FVector(DirectionX[Index], DirectionY[Index], 0.0f));
+	}
+}
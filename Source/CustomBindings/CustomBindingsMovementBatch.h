@@ -0,0 +1,52 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "GameFramework/Actor.h"
+#include "CustomBindingsMovementBatch.generated.h"
+
+class ACustomBindingsCharacter;
+
+/**
+ * Per world movement intent stage. Characters record their MoveForward/MoveRight axis values,
+ * and once per frame this gathers them, builds the yaw basis once per controller in packed
+ * arrays and applies the resulting movement input in one pass.
+ * Ticks after the controllers and other input sources that feed it and before the movement components consuming it.
+ */
+UCLASS(notplaceable, transient)
+class ACustomBindingsMovementBatch : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ACustomBindingsMovementBatch();
+
+	/** Returns the batch of the given world, spawning it on first use */
+	static ACustomBindingsMovementBatch* Get(UWorld* World);
+
+	void Register(ACustomBindingsCharacter* Character);
+
+	void Unregister(ACustomBindingsCharacter* Character);
+
+	/**
+	 * Makes the batch tick after an actor feeding movement intent (a controller processing input,
+	 * or anything calling AddMovementIntent from its tick), so intent fed this frame is applied this frame
+	 */
+	void AddInputSourcePrerequisite(AActor* InputSource);
+
+	void RemoveInputSourcePrerequisite(AActor* InputSource);
+
+	// AActor interface
+	virtual void Tick(float DeltaSeconds) override;
+	// End of AActor interface
+
+private:
+	UPROPERTY(Transient)
+	TArray<ACustomBindingsCharacter*> Characters;
+
+	// Scratch arrays reused every frame, one entry per moving character
+	TArray<ACustomBindingsCharacter*> Moving;
+	TArray<float> Yaw;
+	TArray<float> Forward;
+	TArray<float> Right;
+	TArray<float> DirectionX;
+	TArray<float> DirectionY;
+};
@@ -0,0 +1,192 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomBindings.h"
+#include "CustomBindingsSoakGameMode.h"
+#include "CustomBindingsCharacter.h"
+#include "CustomBindingsMovementBatch.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCustomBindingsSoak, Log, All);
+
+static void SetBatchedMovementInput(bool bEnabled)
+{
+	if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("CustomBindings.BatchedMovementInput")))
+	{
+		CVar->Set(bEnabled ? 1 : 0);
+	}
+}
+
+ACustomBindingsSoakGameMode::ACustomBindingsSoakGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	FrameBudgetMs = 16.6f;
+	CharactersPerStep = 25;
+	FramesPerStep = 60;
+	MaxCharacters = 4000;
+	CharacterClass = ACustomBindingsCharacter::StaticClass();
+	SpawnOrigin = FVector(0.0f, 0.0f, 300.0f);
+	SpawnSpacing = 150.0f;
+
+	Run = 0;
+	RunResults[0] = RunResults[1] = 0;
+	LastFittingCharacters = 0;
+	FramesMeasured = 0;
+	MeasuredFrameTime = 0.0;
+	bSkipNextFrame = false;
+}
+
+void ACustomBindingsSoakGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// measure how long frames take, not how long the engine waits to smooth them
+	GEngine->bSmoothFrameRate = false;
+
+	// characters are driven from this tick, so in the batched run it has to run before the movement batch
+	if (ACustomBindingsMovementBatch* MovementBatch = ACustomBindingsMovementBatch::Get(GetWorld()))
+	{
+		MovementBatch->AddInputSourcePrerequisite(this);
+	}
+
+	SetBatchedMovementInput(false);
+	SpawnCharacters(CharactersPerStep);
+}
+
+void ACustomBindingsSoakGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (Run > 1)
+	{
+		return;
+	}
+
+	DriveCharacters();
+
+	// the frame after spawning pays for the spawns
+	if (bSkipNextFrame)
+	{
+		bSkipNextFrame = false;
+		return;
+	}
+
+	MeasuredFrameTime += FApp::GetDeltaTime();
+	if (++FramesMeasured < FramesPerStep)
+	{
+		return;
+	}
+
+	const float AverageFrameMs = (float)(MeasuredFrameTime / FramesMeasured) * 1000.0f;
+	FramesMeasured = 0;
+	MeasuredFrameTime = 0.0;
+
+	UE_LOG(LogCustomBindingsSoak, Log, TEXT("%d characters: %.2f ms"), Characters.Num(), AverageFrameMs);
+
+	if (AverageFrameMs > FrameBudgetMs)
+	{
+		FinishRun(LastFittingCharacters);
+	}
+	else if (Characters.Num() >= MaxCharacters)
+	{
+		FinishRun(Characters.Num());
+	}
+	else
+	{
+		LastFittingCharacters = Characters.Num();
+		SpawnCharacters(CharactersPerStep);
+	}
+}
+
+void ACustomBindingsSoakGameMode::SpawnCharacters(int32 Count)
+{
+	UWorld* World = GetWorld();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int32 GridSide = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt((float)MaxCharacters)));
+	for (int32 Spawned = 0; Spawned < Count; Spawned++)
+	{
+		const int32 Index = Characters.Num();
+		const FVector Location = SpawnOrigin + FVector((Index % GridSide - GridSide / 2) * SpawnSpacing, (Index / GridSide - GridSide / 2) * SpawnSpacing, 0.0f);
+
+		ACustomBindingsCharacter* Character = World->SpawnActor<ACustomBindingsCharacter>(CharacterClass, Location, FRotator::ZeroRotator, SpawnParams);
+		if (Character == NULL)
+		{
+			break;
+		}
+
+		Character->SpawnDefaultController();
+		Characters.Add(Character);
+
+		// the per character run has no batch in between, so order the movement after this tick directly
+		Character->GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PrimaryActorTick);
+	}
+
+	bSkipNextFrame = true;
+}
+
+void ACustomBindingsSoakGameMode::DestroyCharacters()
+{
+	for (ACustomBindingsCharacter* Character : Characters)
+	{
+		if (Character == NULL || Character->IsPendingKill())
+		{
+			continue;
+		}
+
+		if (AController* CharacterController = Character->GetController())
+		{
+			CharacterController->Destroy();
+		}
+		Character->Destroy();
+	}
+
+	Characters.Reset();
+}
+
+void ACustomBindingsSoakGameMode::DriveCharacters()
+{
+	// characters falling out of the world get destroyed, and nulled by the next garbage collection
+	Characters.RemoveAll([](ACustomBindingsCharacter* Character) { return Character == NULL || Character->IsPendingKill(); });
+
+	const float Time = GetWorld()->GetTimeSeconds();
+
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		ACustomBindingsCharacter* Character = Characters[Index];
+
+		// keep turning so every frame needs a fresh yaw basis
+		if (AController* CharacterController = Character->GetController())
+		{
+			CharacterController->SetControlRotation(FRotator(0.0f, FMath::Fmod(Time * 30.0f + Index * 37.0f, 360.0f), 0.0f));
+		}
+
+		Character->AddMovementIntent(1.0f, FMath::Sin(Time + Index));
+	}
+}
+
+void ACustomBindingsSoakGameMode::FinishRun(int32 FittingCharacters)
+{
+	RunResults[Run] = FittingCharacters;
+	UE_LOG(LogCustomBindingsSoak, Display, TEXT("%s movement input: %d characters fit in %.1f ms"),
+		Run == 0 ? TEXT("Per character") : TEXT("Batched"), FittingCharacters, FrameBudgetMs);
+
+	DestroyCharacters();
+	LastFittingCharacters = 0;
+	FramesMeasured = 0;
+	MeasuredFrameTime = 0.0;
+	Run++;
+
+	if (Run == 1)
+	{
+		SetBatchedMovementInput(true);
+		SpawnCharacters(CharactersPerStep);
+		return;
+	}
+
+	UE_LOG(LogCustomBindingsSoak, Display, TEXT("Soak done, characters in a %.1f ms frame: %d before, %d with the movement batch"),
+		FrameBudgetMs, RunResults[0], RunResults[1]);
+
+	FPlatformMisc::RequestExit(false);
+}
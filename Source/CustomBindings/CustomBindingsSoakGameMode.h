@@ -0,0 +1,78 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "GameFramework/GameModeBase.h"
+#include "CustomBindingsSoakGameMode.generated.h"
+
+class ACustomBindingsCharacter;
+
+/**
+ * Headless soak test for character movement input. Keeps adding AI driven characters while the
+ * average frame fits in FrameBudgetMs and reports how many fit, first with per character movement
+ * input and then with the movement batch (CustomBindings.BatchedMovementInput 0, then 1).
+ *
+ * UE4Editor CustomBindings.uproject /Game/ThirdPersonCPP/Maps/ThirdPersonExampleMap?game=/Script/CustomBindings.CustomBindingsSoakGameMode -game -nullrhi -unattended
+ */
+UCLASS(config=Game)
+class ACustomBindingsSoakGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	ACustomBindingsSoakGameMode();
+
+	/** Frame time, in ms, the characters have to fit in */
+	UPROPERTY(config, EditAnywhere, Category=Soak)
+	float FrameBudgetMs;
+
+	/** Characters added every time the frame still fits in the budget */
+	UPROPERTY(config, EditAnywhere, Category=Soak)
+	int32 CharactersPerStep;
+
+	/** Frames averaged before deciding whether to add more characters */
+	UPROPERTY(config, EditAnywhere, Category=Soak)
+	int32 FramesPerStep;
+
+	UPROPERTY(config, EditAnywhere, Category=Soak)
+	int32 MaxCharacters;
+
+	UPROPERTY(EditAnywhere, Category=Soak)
+	TSubclassOf<ACustomBindingsCharacter> CharacterClass;
+
+	/** Characters are spawned on a grid around this point */
+	UPROPERTY(config, EditAnywhere, Category=Soak)
+	FVector SpawnOrigin;
+
+	UPROPERTY(config, EditAnywhere, Category=Soak)
+	float SpawnSpacing;
+
+	// AActor interface
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+	// End of AActor interface
+
+private:
+	void SpawnCharacters(int32 Count);
+
+	void DestroyCharacters();
+
+	/** Feeds every character a wandering movement intent, the way a bot would */
+	void DriveCharacters();
+
+	void FinishRun(int32 FittingCharacters);
+
+	UPROPERTY(Transient)
+	TArray<ACustomBindingsCharacter*> Characters;
+
+	/** 0: per character movement input, 1: batched movement input, 2: done */
+	int32 Run;
+
+	int32 RunResults[2];
+
+	int32 LastFittingCharacters;
+
+	int32 FramesMeasured;
+
+	double MeasuredFrameTime;
+
+	bool bSkipNextFrame;
+};
@@ -0,0 +1,391 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CustomBindings.h"
+#include "KeyBindingMigrationCommandlet.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
+#include "Runtime/JsonUtilities/Public/JsonObjectConverter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogKeyBindingMigration, Log, All);
+
+/**
+ * Rules resolved once to names, keys and mappings, then only read by the workers.
+ */
+struct FPreparedMigrationRules
+{
+	TMap<FName, FName> ActionRenames;
+	TMap<FName, FName> AxisRenames;
+	TSet<FKey> RemovedKeys;
+	TArray<FInputActionKeyMapping> AddActions;
+	TArray<FInputAxisKeyMapping> AddAxis;
+
+	/** The new defaults the migrated files are layered on */
+	TArray<FInputActionKeyMapping> DefaultActions;
+	TArray<FInputAxisKeyMapping> DefaultAxis;
+};
+
+struct FMigrationFileResult
+{
+	bool bFailed = false;
+	bool bChanged = false;
+	TArray<FString> Conflicts;
+};
+
+
+UKeyBindingMigrationCommandlet::UKeyBindingMigrationCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+/*
+*
+*/
+static bool PrepareMigrationRules(const FKeyBindingMigrationRules& Rules, FPreparedMigrationRules& Out)
+{
+	for (const FKeyBindingRename& Each : Rules.RenameActions)
+	{
+		Out.ActionRenames.Add(FName(*Each.From), FName(*Each.To));
+	}
+
+	for (const FKeyBindingRename& Each : Rules.RenameAxis)
+	{
+		Out.AxisRenames.Add(FName(*Each.From), FName(*Each.To));
+	}
+
+	for (const FString& Each : Rules.RemoveKeys)
+	{
+		const FKey Key(FName(*Each));
+		if (!Key.IsValid())
+		{
+			UE_LOG(LogKeyBindingMigration, Error, TEXT("Unknown key '%s' in RemoveKeys"), *Each);
+			return false;
+		}
+		Out.RemovedKeys.Add(Key);
+	}
+
+	for (const FInputAction& Each : Rules.AddActions)
+	{
+		if (Each.ActionName.IsEmpty() || !Each.Key.IsValid())
+		{
+			UE_LOG(LogKeyBindingMigration, Error, TEXT("Invalid action '%s' in AddActions"), *Each.ActionName);
+			return false;
+		}
+		Out.AddActions.Add(FInputActionKeyMapping(FName(*Each.ActionName), Each.Key, Each.bShift, Each.bCtrl, Each.bAlt, Each.bCmd));
+	}
+
+	for (const FInputAxis& Each : Rules.AddAxis)
+	{
+		if (Each.AxisName.IsEmpty() || !Each.Key.IsValid())
+		{
+			UE_LOG(LogKeyBindingMigration, Error, TEXT("Invalid axis '%s' in AddAxis"), *Each.AxisName);
+			return false;
+		}
+		Out.AddAxis.Add(FInputAxisKeyMapping(FName(*Each.AxisName), Each.Key, Each.Scale));
+	}
+
+	return true;
+}
+
+/*
+* Renames the mapping, returns false if the rules drop its key
+*/
+static bool MigrateMapping(const FPreparedMigrationRules& Rules, FInputActionKeyMapping& Mapping)
+{
+	if (const FName* NewName = Rules.ActionRenames.Find(Mapping.ActionName)) Mapping.ActionName = *NewName;
+
+	return !Rules.RemovedKeys.Contains(Mapping.Key);
+}
+
+/*
+* Renames the mapping, returns false if the rules drop its key
+*/
+static bool MigrateMapping(const FPreparedMigrationRules& Rules, FInputAxisKeyMapping& Mapping)
+{
+	if (const FName* NewName = Rules.AxisRenames.Find(Mapping.AxisName)) Mapping.AxisName = *NewName;
+
+	return !Rules.RemovedKeys.Contains(Mapping.Key);
+}
+
+/*
+* Flags unknown keys, key chords bound to several actions and keys bound to several axis
+*/
+static void FindConflicts(const FString& File, const TArray<FInputActionKeyMapping>& Actions, const TArray<FInputAxisKeyMapping>& Axis, TArray<FString>& OutConflicts)
+{
+	TMap<FString, TArray<FName>> ActionsByChord;
+	for (const FInputActionKeyMapping& Each : Actions)
+	{
+		if (!Each.Key.IsValid())
+		{
+			OutConflicts.Add(FString::Printf(TEXT("\"%s\",InvalidKey,%s,%s"), *File, *Each.Key.ToString(), *Each.ActionName.ToString()));
+			continue;
+		}
+
+		const FString Chord = FString::Printf(TEXT("%s%s%s%s%s"),
+			Each.bCtrl ? TEXT("Ctrl+") : TEXT(""), Each.bAlt ? TEXT("Alt+") : TEXT(""),
+			Each.bShift ? TEXT("Shift+") : TEXT(""), Each.bCmd ? TEXT("Cmd+") : TEXT(""), *Each.Key.ToString());
+		ActionsByChord.FindOrAdd(Chord).AddUnique(Each.ActionName);
+	}
+
+	TMap<FKey, TArray<FName>> AxisByKey;
+	for (const FInputAxisKeyMapping& Each : Axis)
+	{
+		if (!Each.Key.IsValid())
+		{
+			OutConflicts.Add(FString::Printf(TEXT("\"%s\",InvalidKey,%s,%s"), *File, *Each.Key.ToString(), *Each.AxisName.ToString()));
+			continue;
+		}
+
+		AxisByKey.FindOrAdd(Each.Key).AddUnique(Each.AxisName);
+	}
+
+	for (const auto& Each : ActionsByChord)
+	{
+		if (Each.Value.Num() < 2) continue;
+
+		FString Names;
+		for (const FName& Name : Each.Value) Names += (Names.IsEmpty() ? TEXT("") : TEXT(";")) + Name.ToString();
+		OutConflicts.Add(FString::Printf(TEXT("\"%s\",Action,%s,%s"), *File, *Each.Key, *Names));
+	}
+
+	for (const auto& Each : AxisByKey)
+	{
+		if (Each.Value.Num() < 2) continue;
+
+		FString Names;
+		for (const FName& Name : Each.Value) Names += (Names.IsEmpty() ? TEXT("") : TEXT(";")) + Name.ToString();
+		OutConflicts.Add(FString::Printf(TEXT("\"%s\",Axis,%s,%s"), *File, *Each.Key.ToString(), *Names));
+	}
+}
+
+/*
+* Rewrites the mapping entries in place, keeping their operators, so the file stays a layer on top of
+* the defaults; arrays the file does not define are left to the defaults. Every other line is kept as is.
+*/
+static void MigrateFile(const FString& InputFile, const FString& OutputFile, const FPreparedMigrationRules& Rules, FMigrationFileResult& Result)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *InputFile))
+	{
+		Result.bFailed = true;
+		return;
+	}
+
+	TArray<FString> Lines;
+	Text.ParseIntoArrayLines(Lines, false);
+
+	TArray<FString> OutLines;
+	OutLines.Reserve(Lines.Num());
+
+	//What the file already adds, so running the migration twice does not add the new mappings twice
+	FInputActionKeyMappingSet ListedActions;
+	FInputAxisKeyMappingSet ListedAxis;
+
+	bool bDefinesActions = false;
+	bool bDefinesAxis = false;
+	int32 MappingsEnd = INDEX_NONE;
+	bool bInSection = false;
+	for (const FString& Line : Lines)
+	{
+		FString Trimmed = Line;
+		Trimmed.Trim();
+		Trimmed.TrimTrailing();
+		if (Trimmed.StartsWith(TEXT("[")))
+		{
+			bInSection = Trimmed == TEXT("[/Script/Engine.InputSettings]");
+			OutLines.Add(Line);
+			continue;
+		}
+
+		TCHAR Operator = 0;
+		bool bIsAction = false;
+		FInputActionKeyMapping Action;
+		FInputAxisKeyMapping Axis;
+		if (!bInSection || !UKeyBindingUtil::ParseInputSettingsEntry(Trimmed, Operator, bIsAction, Action, Axis))
+		{
+			OutLines.Add(Line);
+			continue;
+		}
+
+		bDefinesActions |= bIsAction;
+		bDefinesAxis |= !bIsAction;
+
+		if (Operator == TEXT('!'))
+		{
+			OutLines.Add(Line);
+		}
+		else if (bIsAction ? MigrateMapping(Rules, Action) : MigrateMapping(Rules, Axis))
+		{
+			const FString Prefix = Operator != 0 ? FString::Chr(Operator) : FString();
+			if (bIsAction)
+			{
+				OutLines.Add(Prefix + TEXT("ActionMappings=") + UKeyBindingUtil::ExportInputSettingsValue(Action));
+				if (Operator != TEXT('-')) ListedActions.Add(Action);
+			}
+			else
+			{
+				OutLines.Add(Prefix + TEXT("AxisMappings=") + UKeyBindingUtil::ExportInputSettingsValue(Axis));
+				if (Operator != TEXT('-')) ListedAxis.Add(Axis);
+			}
+		}
+
+		MappingsEnd = OutLines.Num();
+	}
+
+	//The new mappings reach arrays the file does not define through the defaults, the others need them added
+	TArray<FString> Additions;
+	if (bDefinesActions)
+	{
+		for (const FInputActionKeyMapping& Each : Rules.AddActions)
+		{
+			if (!ListedActions.Contains(Each)) Additions.Add(TEXT("+ActionMappings=") + UKeyBindingUtil::ExportInputSettingsValue(Each));
+		}
+	}
+	if (bDefinesAxis)
+	{
+		for (const FInputAxisKeyMapping& Each : Rules.AddAxis)
+		{
+			if (!ListedAxis.Contains(Each)) Additions.Add(TEXT("+AxisMappings=") + UKeyBindingUtil::ExportInputSettingsValue(Each));
+		}
+	}
+	if (Additions.Num() > 0)
+	{
+		OutLines.Insert(Additions, MappingsEnd);
+	}
+
+	Result.bChanged = OutLines != Lines;
+
+	//Conflicts are about what the player ends up with: the new defaults with the migrated file on top
+	TArray<FInputActionKeyMapping> EffectiveActions = Rules.DefaultActions;
+	TArray<FInputAxisKeyMapping> EffectiveAxis = Rules.DefaultAxis;
+	FInputMappingsParseState State;
+	UKeyBindingUtil::ParseInputSettingsSection(OutLines, EffectiveActions, EffectiveAxis, State);
+	FindConflicts(InputFile, EffectiveActions, EffectiveAxis, Result.Conflicts);
+
+	const FString OutText = FString::Join(OutLines, LINE_TERMINATOR) + LINE_TERMINATOR;
+	if (!FFileHelper::SaveStringToFile(OutText, *OutputFile))
+	{
+		Result.bFailed = true;
+	}
+}
+
+/*
+*
+*/
+static void WriteReportLine(FArchive& Report, const FString& Line)
+{
+	FTCHARToUTF8 Utf8(*(Line + LINE_TERMINATOR));
+	Report.Serialize((void*)Utf8.Get(), Utf8.Length());
+}
+
+/*
+*
+*/
+int32 UKeyBindingMigrationCommandlet::Main(const FString& Params)
+{
+	FString InputDir, OutputDir, RulesPath, ReportPath;
+	if (!FParse::Value(*Params, TEXT("InputDir="), InputDir, false)
+		|| !FParse::Value(*Params, TEXT("OutputDir="), OutputDir, false)
+		|| !FParse::Value(*Params, TEXT("Rules="), RulesPath, false))
+	{
+		UE_LOG(LogKeyBindingMigration, Error, TEXT("Usage: -run=KeyBindingMigration -InputDir=<dir> -OutputDir=<dir> -Rules=<rules.json> [-Defaults=<DefaultInput.ini>] [-Report=<conflicts.csv>] [-BatchSize=<files>]"));
+		return 1;
+	}
+
+	if (!FParse::Value(*Params, TEXT("Report="), ReportPath, false))
+	{
+		ReportPath = FPaths::Combine(*OutputDir, TEXT("Conflicts.csv"));
+	}
+
+	//A few files per core keeps every worker busy while only one batch is held in memory
+	int32 BatchSize = 0;
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	if (BatchSize <= 0)
+	{
+		BatchSize = FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads()) * 16;
+	}
+
+	FString RulesJson;
+	FKeyBindingMigrationRules Rules;
+	if (!FFileHelper::LoadFileToString(RulesJson, *RulesPath) || !FJsonObjectConverter::JsonObjectStringToUStruct(RulesJson, &Rules, 0, 0))
+	{
+		UE_LOG(LogKeyBindingMigration, Error, TEXT("Could not read rules from %s"), *RulesPath);
+		return 1;
+	}
+
+	FPreparedMigrationRules PreparedRules;
+	if (!PrepareMigrationRules(Rules, PreparedRules)) return 1;
+
+	FString DefaultsPath;
+	FParse::Value(*Params, TEXT("Defaults="), DefaultsPath, false);
+	if (!UKeyBindingUtil::LoadDefaultInputBindings(DefaultsPath, PreparedRules.DefaultActions, PreparedRules.DefaultAxis))
+	{
+		UE_LOG(LogKeyBindingMigration, Error, TEXT("Could not read the default bindings from %s"), DefaultsPath.IsEmpty() ? TEXT("DefaultInput.ini") : *DefaultsPath);
+		return 1;
+	}
+
+	const FString InputRoot = InputDir / TEXT("");
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFilesRecursive(Files, *InputRoot, TEXT("*.ini"), true, false);
+	Files.Sort();
+
+	TUniquePtr<FArchive> Report(IFileManager::Get().CreateFileWriter(*ReportPath));
+	if (!Report)
+	{
+		UE_LOG(LogKeyBindingMigration, Error, TEXT("Could not create report %s"), *ReportPath);
+		return 1;
+	}
+	WriteReportLine(*Report, TEXT("File,Type,Binding,Names"));
+
+	UE_LOG(LogKeyBindingMigration, Display, TEXT("Migrating %d files from %s to %s"), Files.Num(), *InputRoot, *OutputDir);
+
+	int32 NumChanged = 0;
+	int32 NumFailed = 0;
+	int32 NumConflicts = 0;
+
+	TArray<FMigrationFileResult> Results;
+	for (int32 BatchStart = 0; BatchStart < Files.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchCount = FMath::Min(BatchSize, Files.Num() - BatchStart);
+		Results.Reset();
+		Results.SetNum(BatchCount);
+
+		ParallelFor(BatchCount, [&](int32 Index)
+		{
+			const FString& InputFile = Files[BatchStart + Index];
+
+			FString RelativePath = InputFile;
+			FPaths::MakePathRelativeTo(RelativePath, *InputRoot);
+
+			MigrateFile(InputFile, FPaths::Combine(*OutputDir, *RelativePath), PreparedRules, Results[Index]);
+		});
+
+		//Written in file order from this thread, so the report does not depend on scheduling
+		for (int32 Index = 0; Index < BatchCount; Index++)
+		{
+			const FMigrationFileResult& Result = Results[Index];
+			if (Result.bFailed)
+			{
+				UE_LOG(LogKeyBindingMigration, Warning, TEXT("Failed to migrate %s"), *Files[BatchStart + Index]);
+				NumFailed++;
+			}
+
+			NumChanged += Result.bChanged ? 1 : 0;
+			NumConflicts += Result.Conflicts.Num();
+			for (const FString& Each : Result.Conflicts)
+			{
+				WriteReportLine(*Report, Each);
+			}
+		}
+
+		UE_LOG(LogKeyBindingMigration, Display, TEXT("%d/%d files processed"), BatchStart + BatchCount, Files.Num());
+	}
+
+	Report->Close();
+
+	UE_LOG(LogKeyBindingMigration, Display, TEXT("Done: %d changed, %d failed, %d conflicts reported to %s"), NumChanged, NumFailed, NumConflicts, *ReportPath);
+
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CustomBindings.h"
+#include "InputConfigWatcher.h"
+#include "Runtime/Core/Public/Async/Async.h"
+#include "Runtime/Engine/Classes/GameFramework/InputSettings.h"
+
+
+FInputConfigWatcher::FInputConfigWatcher(const FString& InFilePath, float InPollInterval)
+	: FilePath(InFilePath)
+	, PollInterval(InPollInterval)
+	, LastTimeStamp(FDateTime::MinValue())
+	, LastFileSize(-1)
+	, PendingTimeStamp(FDateTime::MinValue())
+	, PendingFileSize(-1)
+	, bParseInFlight(false)
+{
+}
+
+/*
+* Only edits made after this call are applied
+*/
+bool FInputConfigWatcher::Start()
+{
+	if (TickerHandle.IsValid()) return true;
+
+	//Without the lower layers every binding the file does not override would look removed
+	if (!UKeyBindingUtil::LoadDefaultInputBindings(FString(), DefaultActions, DefaultAxis)) return false;
+
+	LastTimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+	LastFileSize = IFileManager::Get().FileSize(*FilePath);
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateThreadSafeSP(this, &FInputConfigWatcher::Poll), PollInterval);
+
+	return true;
+}
+
+/*
+*
+*/
+void FInputConfigWatcher::Stop()
+{
+	if (!TickerHandle.IsValid()) return;
+
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+}
+
+/*
+*
+*/
+bool FInputConfigWatcher::Poll(float DeltaTime)
+{
+	if (bParseInFlight) return true;
+
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+	const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+	if (TimeStamp == FDateTime::MinValue() || FileSize < 0) return true;
+	if (TimeStamp == LastTimeStamp && FileSize == LastFileSize) return true;
+
+	//The file may still be being written, only parse it once it stayed the same for a whole poll
+	if (TimeStamp != PendingTimeStamp || FileSize != PendingFileSize)
+	{
+		PendingTimeStamp = TimeStamp;
+		PendingFileSize = FileSize;
+		return true;
+	}
+
+	LastTimeStamp = TimeStamp;
+	LastFileSize = FileSize;
+	bParseInFlight = true;
+
+	TWeakPtr<FInputConfigWatcher, ESPMode::ThreadSafe> WeakThis = AsShared();
+	const FString Path = FilePath;
+
+	//The saved file is only the top layer, its entries apply on top of the defaults
+	TArray<FInputActionKeyMapping> Actions = DefaultActions;
+	TArray<FInputAxisKeyMapping> Axis = DefaultAxis;
+
+	Async<void>(EAsyncExecution::ThreadPool, [WeakThis, Path, Actions, Axis]() mutable
+	{
+		FString Text;
+		const bool bRead = FFileHelper::LoadFileToString(Text, *Path);
+		if (bRead)
+		{
+			TArray<FString> Lines;
+			Text.ParseIntoArrayLines(Lines);
+
+			FInputMappingsParseState State;
+			UKeyBindingUtil::ParseInputSettingsSection(Lines, Actions, Axis, State);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bRead, Actions, Axis]()
+		{
+			TSharedPtr<FInputConfigWatcher, ESPMode::ThreadSafe> Watcher = WeakThis.Pin();
+			if (Watcher.IsValid())
+			{
+				Watcher->OnParsed(bRead, Actions, Axis);
+			}
+		});
+	});
+
+	return true;
+}
+
+/*
+* Runs on the game thread, so the diff is always against the current bindings
+*/
+void FInputConfigWatcher::OnParsed(bool bRead, const TArray<FInputActionKeyMapping>& Actions, const TArray<FInputAxisKeyMapping>& Axis)
+{
+	bParseInFlight = false;
+
+	//Forget this version so the next poll reads it again
+	if (!bRead)
+	{
+		LastTimeStamp = FDateTime::MinValue();
+		LastFileSize = -1;
+		return;
+	}
+
+	const UInputSettings* Settings = GetDefault<UInputSettings>();
+	if (!Settings) return;
+
+	FInputBindingsDiff Diff;
+	UKeyBindingUtil::DiffBindings(Settings->ActionMappings, Settings->AxisMappings, Actions, Axis, Diff);
+
+	//The file already holds these bindings, no need to save them back
+	UKeyBindingUtil::ApplyBindingsDiff(Diff, false);
+}
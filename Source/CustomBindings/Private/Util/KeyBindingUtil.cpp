@@ -2,10 +2,15 @@
 
 #include "CustomBindings.h"
 #include "KeyBindingUtil.h"
+#include "InputConfigWatcher.h"
 #include "Runtime/Engine/Classes/GameFramework/InputSettings.h"
 #include "Runtime/CoreUObject/Public/UObject/UObjectGlobals.h"
+#include "Runtime/Json/Public/Json.h"
+#include "Runtime/JsonUtilities/Public/JsonObjectConverter.h"
 
 
+static TSharedPtr<FInputConfigWatcher, ESPMode::ThreadSafe> InputConfigWatcher;
+
 UKeyBindingUtil::UKeyBindingUtil(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
@@ -31,6 +36,19 @@ void UKeyBindingUtil::UpdateActionBinding(const FInputAction& SrcInputAction, FI
 	DstInputAction.bCmd = SrcInputAction.bCmd;
 }
 
+/*
+* Saves to disk and rebuilds every player's key maps, once per batch of changes
+*/
+void UKeyBindingUtil::SaveAndRebuildKeyMappings(UInputSettings* Settings)
+{
+	Settings->SaveKeyMappings();
+
+	for (TObjectIterator<UPlayerInput> It; It; ++It)
+	{
+		It->ForceRebuildingKeyMaps(true);
+	}
+}
+
 /*
 *
 */
@@ -355,3 +373,449 @@ bool UKeyBindingUtil::RemoveActionBinding(FInputAction BindingToRemove)
 	return Found;
 }
 
+
+/*
+*
+*/
+void UKeyBindingUtil::ExportBindings(FInputBindingsProfile& Profile)
+{
+	GetAllBindedInputActions(Profile.Actions);
+	GetAllBindedInputAxis(Profile.Axis);
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ImportBindings(const FInputBindingsProfile& Profile, EBindingImportPolicy Policy)
+{
+	UInputSettings* Settings = GetMutableDefault<UInputSettings>();
+	if (!Settings) return false;
+
+	//Validate everything first so a bad entry never leaves the settings half imported
+	for (const FInputAction& Each : Profile.Actions)
+	{
+		if (Each.ActionName.IsEmpty() || !Each.Key.IsValid()) return false;
+	}
+
+	for (const FInputAxis& Each : Profile.Axis)
+	{
+		if (Each.AxisName.IsEmpty() || !Each.Key.IsValid()) return false;
+	}
+
+	TArray<FInputActionKeyMapping>& Actions = Settings->ActionMappings;
+	TArray<FInputAxisKeyMapping>& Axis = Settings->AxisMappings;
+
+	bool bChanged = false;
+	if (Policy == EBindingImportPolicy::Replace)
+	{
+		bChanged = Actions.Num() > 0 || Axis.Num() > 0;
+		Actions.Reset();
+		Axis.Reset();
+	}
+
+	//Hash sets keep the dedupe linear, instead of one AddUnique scan per imported binding
+	FInputActionKeyMappingSet ActionSet;
+	ActionSet.Reserve(Actions.Num() + Profile.Actions.Num());
+	for (const FInputActionKeyMapping& Each : Actions)
+	{
+		ActionSet.Add(Each);
+	}
+
+	for (const FInputAction& Each : Profile.Actions)
+	{
+		FInputActionKeyMapping Mapping(FName(*Each.ActionName), Each.Key, Each.bShift, Each.bCtrl, Each.bAlt, Each.bCmd);
+
+		bool bAlreadyBound = false;
+		ActionSet.Add(Mapping, &bAlreadyBound);
+		if (!bAlreadyBound)
+		{
+			Actions.Add(Mapping);
+			bChanged = true;
+		}
+	}
+
+	FInputAxisKeyMappingSet AxisSet;
+	AxisSet.Reserve(Axis.Num() + Profile.Axis.Num());
+	for (const FInputAxisKeyMapping& Each : Axis)
+	{
+		AxisSet.Add(Each);
+	}
+
+	for (const FInputAxis& Each : Profile.Axis)
+	{
+		FInputAxisKeyMapping Mapping(FName(*Each.AxisName), Each.Key, Each.Scale);
+
+		bool bAlreadyBound = false;
+		AxisSet.Add(Mapping, &bAlreadyBound);
+		if (!bAlreadyBound)
+		{
+			Axis.Add(Mapping);
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		UKeyBindingUtil::SaveAndRebuildKeyMappings(Settings);
+	}
+
+	return true;
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ExportBindingsToFile(const FString& FilePath)
+{
+	FInputBindingsProfile Profile;
+	UKeyBindingUtil::ExportBindings(Profile);
+
+	FString JsonString;
+	if (!FJsonObjectConverter::UStructToJsonObjectString(FInputBindingsProfile::StaticStruct(), &Profile, JsonString, 0, 0)) return false;
+
+	return FFileHelper::SaveStringToFile(JsonString, *FilePath);
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ImportBindingsFromFile(const FString& FilePath, EBindingImportPolicy Policy)
+{
+	FString JsonString;
+	if (!FFileHelper::LoadFileToString(JsonString, *FilePath)) return false;
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(JsonReader, JsonObject) || !JsonObject.IsValid()) return false;
+
+	//Any JSON object converts, so a wrong or empty file would otherwise replace every binding with nothing
+	if (!JsonObject->HasField(TEXT("Actions")) && !JsonObject->HasField(TEXT("Axis"))) return false;
+
+	FInputBindingsProfile Profile;
+	if (!FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), FInputBindingsProfile::StaticStruct(), &Profile, 0, 0)) return false;
+
+	return UKeyBindingUtil::ImportBindings(Profile, Policy);
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::StartWatchingInputConfig(const FString& FilePath, float PollInterval)
+{
+	UKeyBindingUtil::StopWatchingInputConfig();
+
+	//The ticker the watcher polls from is gone by the time statics are destroyed
+	static bool bStopOnExitRegistered = false;
+	if (!bStopOnExitRegistered)
+	{
+		FCoreDelegates::OnPreExit.AddStatic(&UKeyBindingUtil::StopWatchingInputConfig);
+		bStopOnExitRegistered = true;
+	}
+
+	InputConfigWatcher = MakeShareable(new FInputConfigWatcher(FilePath.IsEmpty() ? GInputIni : FilePath, PollInterval));
+	if (!InputConfigWatcher->Start())
+	{
+		InputConfigWatcher.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+*
+*/
+void UKeyBindingUtil::StopWatchingInputConfig()
+{
+	if (!InputConfigWatcher.IsValid()) return;
+
+	InputConfigWatcher->Stop();
+	InputConfigWatcher.Reset();
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ParseInputSettingsEntry(const FString& Line, TCHAR& OutOperator, bool& bOutIsAction, FInputActionKeyMapping& OutAction, FInputAxisKeyMapping& OutAxis)
+{
+	FString Entry = Line;
+	Entry.Trim();
+	Entry.TrimTrailing();
+	if (Entry.IsEmpty()) return false;
+
+	//Same array operators the config system uses
+	OutOperator = 0;
+	if (Entry[0] == TEXT('+') || Entry[0] == TEXT('.') || Entry[0] == TEXT('-') || Entry[0] == TEXT('!'))
+	{
+		OutOperator = Entry[0];
+		Entry = Entry.Mid(1);
+	}
+
+	FString Name, Value;
+	if (!Entry.Split(TEXT("="), &Name, &Value)) return false;
+
+	const bool bIsAction = Name == TEXT("ActionMappings");
+	const bool bIsAxis = Name == TEXT("AxisMappings");
+	if (!bIsAction && !bIsAxis) return false;
+
+	bOutIsAction = bIsAction;
+	if (OutOperator == TEXT('!')) return true;
+
+	Value.RemoveFromStart(TEXT("("));
+	Value.RemoveFromEnd(TEXT(")"));
+
+	FString KeyName;
+	if (!FParse::Value(*Value, TEXT("Key="), KeyName)) return false;
+
+	if (bIsAction)
+	{
+		FString ActionName;
+		if (!FParse::Value(*Value, TEXT("ActionName="), ActionName)) return false;
+
+		bool bShift = false, bCtrl = false, bAlt = false, bCmd = false;
+		FParse::Bool(*Value, TEXT("bShift="), bShift);
+		FParse::Bool(*Value, TEXT("bCtrl="), bCtrl);
+		FParse::Bool(*Value, TEXT("bAlt="), bAlt);
+		FParse::Bool(*Value, TEXT("bCmd="), bCmd);
+
+		OutAction = FInputActionKeyMapping(FName(*ActionName), FKey(FName(*KeyName)), bShift, bCtrl, bAlt, bCmd);
+	}
+	else
+	{
+		FString AxisName;
+		if (!FParse::Value(*Value, TEXT("AxisName="), AxisName)) return false;
+
+		float Scale = 1.f;
+		FParse::Value(*Value, TEXT("Scale="), Scale);
+
+		OutAxis = FInputAxisKeyMapping(FName(*AxisName), FKey(FName(*KeyName)), Scale);
+	}
+
+	return true;
+}
+
+/*
+* ! clears, - removes, + adds if missing, . always adds and a plain entry replaces the lower layers
+*/
+template<typename MappingType>
+static void ApplyInputSettingsOperator(TCHAR Operator, const MappingType& Mapping, TArray<MappingType>& Mappings, bool& bReplaced)
+{
+	switch (Operator)
+	{
+	case TEXT('!'):
+		Mappings.Reset();
+		break;
+	case TEXT('-'):
+		Mappings.Remove(Mapping);
+		break;
+	case TEXT('+'):
+		Mappings.AddUnique(Mapping);
+		break;
+	case TEXT('.'):
+		Mappings.Add(Mapping);
+		break;
+	default:
+		if (!bReplaced)
+		{
+			Mappings.Reset();
+			bReplaced = true;
+		}
+		Mappings.Add(Mapping);
+		break;
+	}
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ParseInputSettingsLine(const FString& Line, TArray<FInputActionKeyMapping>& Actions, TArray<FInputAxisKeyMapping>& Axis, FInputMappingsParseState& State)
+{
+	TCHAR Operator = 0;
+	bool bIsAction = false;
+	FInputActionKeyMapping Action;
+	FInputAxisKeyMapping AxisMapping;
+	if (!UKeyBindingUtil::ParseInputSettingsEntry(Line, Operator, bIsAction, Action, AxisMapping)) return false;
+
+	if (bIsAction)
+	{
+		ApplyInputSettingsOperator(Operator, Action, Actions, State.bReplacedActions);
+		State.bDefinesActions = true;
+	}
+	else
+	{
+		ApplyInputSettingsOperator(Operator, AxisMapping, Axis, State.bReplacedAxis);
+		State.bDefinesAxis = true;
+	}
+
+	return true;
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ParseInputSettingsSection(const TArray<FString>& Lines, TArray<FInputActionKeyMapping>& Actions, TArray<FInputAxisKeyMapping>& Axis, FInputMappingsParseState& State)
+{
+	bool bFoundSection = false;
+	bool bInSection = false;
+	for (const FString& Each : Lines)
+	{
+		FString Line = Each;
+		Line.Trim();
+		Line.TrimTrailing();
+		if (Line.StartsWith(TEXT("[")))
+		{
+			bInSection = Line == TEXT("[/Script/Engine.InputSettings]");
+			bFoundSection |= bInSection;
+			continue;
+		}
+
+		if (bInSection)
+		{
+			UKeyBindingUtil::ParseInputSettingsLine(Line, Actions, Axis, State);
+		}
+	}
+
+	return bFoundSection;
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::LoadDefaultInputBindings(const FString& DefaultInputPath, TArray<FInputActionKeyMapping>& OutActions, TArray<FInputAxisKeyMapping>& OutAxis)
+{
+	OutActions.Empty();
+	OutAxis.Empty();
+
+	const FString Layers[] =
+	{
+		FPaths::EngineConfigDir() / TEXT("BaseInput.ini"),
+		DefaultInputPath.IsEmpty() ? FPaths::SourceConfigDir() / TEXT("DefaultInput.ini") : DefaultInputPath
+	};
+
+	bool bLoadedDefaults = false;
+	for (const FString& Layer : Layers)
+	{
+		FString Text;
+		bLoadedDefaults = FFileHelper::LoadFileToString(Text, *Layer);
+		if (!bLoadedDefaults) continue;
+
+		TArray<FString> Lines;
+		Text.ParseIntoArrayLines(Lines);
+
+		//Each file starts its own section, so plain entries replace the layers below once more
+		FInputMappingsParseState State;
+		UKeyBindingUtil::ParseInputSettingsSection(Lines, OutActions, OutAxis, State);
+	}
+
+	//Only the project defaults have to be there
+	return bLoadedDefaults;
+}
+
+/*
+*
+*/
+FString UKeyBindingUtil::ExportInputSettingsValue(const FInputActionKeyMapping& Mapping)
+{
+	return FString::Printf(TEXT("(ActionName=\"%s\",Key=%s,bShift=%s,bCtrl=%s,bAlt=%s,bCmd=%s)"),
+		*Mapping.ActionName.ToString(), *Mapping.Key.ToString(),
+		Mapping.bShift ? TEXT("True") : TEXT("False"), Mapping.bCtrl ? TEXT("True") : TEXT("False"),
+		Mapping.bAlt ? TEXT("True") : TEXT("False"), Mapping.bCmd ? TEXT("True") : TEXT("False"));
+}
+
+/*
+*
+*/
+FString UKeyBindingUtil::ExportInputSettingsValue(const FInputAxisKeyMapping& Mapping)
+{
+	return FString::Printf(TEXT("(AxisName=\"%s\",Key=%s,Scale=%f)"), *Mapping.AxisName.ToString(), *Mapping.Key.ToString(), Mapping.Scale);
+}
+
+/*
+*
+*/
+void UKeyBindingUtil::DiffBindings(const TArray<FInputActionKeyMapping>& CurrentActions, const TArray<FInputAxisKeyMapping>& CurrentAxis,
+	const TArray<FInputActionKeyMapping>& DesiredActions, const TArray<FInputAxisKeyMapping>& DesiredAxis, FInputBindingsDiff& OutDiff)
+{
+	OutDiff = FInputBindingsDiff();
+
+	FInputActionKeyMappingSet CurrentActionSet;
+	CurrentActionSet.Append(CurrentActions);
+	FInputActionKeyMappingSet DesiredActionSet;
+	DesiredActionSet.Reserve(DesiredActions.Num());
+	for (const FInputActionKeyMapping& Each : DesiredActions)
+	{
+		bool bAlreadyInSet = false;
+		DesiredActionSet.Add(Each, &bAlreadyInSet);
+		if (!bAlreadyInSet && !CurrentActionSet.Contains(Each)) OutDiff.ActionsToAdd.Add(Each);
+	}
+
+	for (const FInputActionKeyMapping& Each : CurrentActionSet)
+	{
+		if (!DesiredActionSet.Contains(Each)) OutDiff.ActionsToRemove.Add(Each);
+	}
+
+	FInputAxisKeyMappingSet CurrentAxisSet;
+	CurrentAxisSet.Append(CurrentAxis);
+	FInputAxisKeyMappingSet DesiredAxisSet;
+	DesiredAxisSet.Reserve(DesiredAxis.Num());
+	for (const FInputAxisKeyMapping& Each : DesiredAxis)
+	{
+		bool bAlreadyInSet = false;
+		DesiredAxisSet.Add(Each, &bAlreadyInSet);
+		if (!bAlreadyInSet && !CurrentAxisSet.Contains(Each)) OutDiff.AxisToAdd.Add(Each);
+	}
+
+	for (const FInputAxisKeyMapping& Each : CurrentAxisSet)
+	{
+		if (!DesiredAxisSet.Contains(Each)) OutDiff.AxisToRemove.Add(Each);
+	}
+}
+
+/*
+* Removes and appends in place, so players keep the rest of their mappings
+*/
+template<typename MappingType, typename SetType>
+static void ApplyMappingsDiff(TArray<MappingType>& Mappings, const SetType& ToRemove, const TArray<MappingType>& ToAdd)
+{
+	if (ToRemove.Num() > 0)
+	{
+		Mappings.RemoveAll([&ToRemove](const MappingType& Each) { return ToRemove.Contains(Each); });
+	}
+
+	Mappings.Append(ToAdd);
+}
+
+/*
+*
+*/
+bool UKeyBindingUtil::ApplyBindingsDiff(const FInputBindingsDiff& Diff, bool bSaveToDisk)
+{
+	if (Diff.Num() == 0) return false;
+
+	UInputSettings* Settings = GetMutableDefault<UInputSettings>();
+	if (!Settings) return false;
+
+	FInputActionKeyMappingSet ActionsToRemove;
+	ActionsToRemove.Append(Diff.ActionsToRemove);
+	FInputAxisKeyMappingSet AxisToRemove;
+	AxisToRemove.Append(Diff.AxisToRemove);
+
+	ApplyMappingsDiff(Settings->ActionMappings, ActionsToRemove, Diff.ActionsToAdd);
+	ApplyMappingsDiff(Settings->AxisMappings, AxisToRemove, Diff.AxisToAdd);
+
+	if (bSaveToDisk)
+	{
+		Settings->SaveKeyMappings();
+	}
+
+	for (TObjectIterator<UPlayerInput> It; It; ++It)
+	{
+		ApplyMappingsDiff(It->ActionMappings, ActionsToRemove, Diff.ActionsToAdd);
+		ApplyMappingsDiff(It->AxisMappings, AxisToRemove, Diff.AxisToAdd);
+
+		//Only drops the cached key maps, they are rebuilt from the edited mappings on next use
+		It->ForceRebuildingKeyMaps(false);
+	}
+
+	return true;
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "KeyBindingUtil.h"
+#include "KeyBindingMigrationCommandlet.generated.h"
+
+USTRUCT()
+struct FKeyBindingRename
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FString From;
+
+	UPROPERTY()
+	FString To;
+};
+
+/**
+ * Declarative ruleset applied to every migrated config file, loaded from JSON.
+ * Renames run first, then keys are removed, then new mappings are added.
+ */
+USTRUCT()
+struct FKeyBindingMigrationRules
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FKeyBindingRename> RenameActions;
+
+	UPROPERTY()
+	TArray<FKeyBindingRename> RenameAxis;
+
+	/** Every mapping bound to one of these keys is dropped */
+	UPROPERTY()
+	TArray<FString> RemoveKeys;
+
+	UPROPERTY()
+	TArray<FInputAction> AddActions;
+
+	UPROPERTY()
+	TArray<FInputAxis> AddAxis;
+};
+
+/**
+ * Migrates a directory of player Input.ini files to new default bindings and reports conflicts
+ * in the bindings players end up with, i.e. the new defaults (Defaults, or the project
+ * DefaultInput.ini) with each file on top. Files are processed in parallel, a bounded batch
+ * at a time, and mirrored into OutputDir.
+ *
+ * UE4Editor-Cmd CustomBindings.uproject -run=KeyBindingMigration -InputDir=<dir> -OutputDir=<dir> -Rules=<rules.json>
+ *     [-Defaults=<DefaultInput.ini>] [-Report=<conflicts.csv>] [-BatchSize=<files>] -nullrhi -unattended
+ */
+UCLASS()
+class UKeyBindingMigrationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UKeyBindingMigrationCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "KeyBindingUtil.h"
+
+/**
+ * Polls an input config file and applies external edits to the live bindings.
+ * The game thread only checks the file time stamp and size and applies the diff; reading
+ * and parsing the file, on top of the default config layers loaded once at start, happens on a pool thread.
+ * A file without an input settings section holds no overrides, so the defaults apply.
+ */
+class CUSTOMBINDINGS_API FInputConfigWatcher : public TSharedFromThis<FInputConfigWatcher, ESPMode::ThreadSafe>
+{
+public:
+	FInputConfigWatcher(const FString& InFilePath, float InPollInterval);
+
+	/** Returns false if the default bindings cannot be read */
+	bool Start();
+
+	void Stop();
+
+	const FString& GetFilePath() const { return FilePath; }
+
+private:
+	bool Poll(float DeltaTime);
+
+	void OnParsed(bool bRead, const TArray<FInputActionKeyMapping>& Actions, const TArray<FInputAxisKeyMapping>& Axis);
+
+	FString FilePath;
+
+	float PollInterval;
+
+	/** Mappings of the config layers below the watched file */
+	TArray<FInputActionKeyMapping> DefaultActions;
+	TArray<FInputAxisKeyMapping> DefaultAxis;
+
+	/** Version of the file last parsed */
+	FDateTime LastTimeStamp;
+	int64 LastFileSize;
+
+	/** Version seen on the previous poll, parsed once it stays the same for a whole poll */
+	FDateTime PendingTimeStamp;
+	int64 PendingFileSize;
+
+	FDelegateHandle TickerHandle;
+
+	bool bParseInFlight;
+};
@@ -34,7 +34,12 @@ struct FInputAction
 	uint32 bCmd : 1;
 
 
-	FInputAction() {}
+	FInputAction()
+		: bShift(false)
+		, bCtrl(false)
+		, bAlt(false)
+		, bCmd(false)
+	{ }
 	FInputAction(const FString InActionName, const FKey InKey, const bool bInShift, const bool bInCtrl, const bool bInAlt, const bool bInCmd)
 		: Key(InKey)
 		, KeyAsString(Key.GetDisplayName().ToString())
@@ -92,6 +97,108 @@ struct FInputAxis
 	}
 };
 
+UENUM(BlueprintType)
+enum class EBindingImportPolicy : uint8
+{
+	/** Keep the current bindings and add the imported ones that are not bound yet */
+	Merge,
+	/** Drop the current bindings and use only the imported ones */
+	Replace
+};
+
+/**
+ * The complete set of action and axis bindings, as imported/exported in one go.
+ */
+USTRUCT(BlueprintType)
+struct FInputBindingsProfile
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Bindings")
+	TArray<FInputAction> Actions;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Bindings")
+	TArray<FInputAxis> Axis;
+};
+
+/**
+ * TSet key funcs hashing every field compared by FInputActionKeyMapping::operator==,
+ * so a set lookup gives the same answer as AddUnique in constant time.
+ */
+struct FInputActionKeyMappingKeyFuncs : BaseKeyFuncs<FInputActionKeyMapping, FInputActionKeyMapping>
+{
+	static FORCEINLINE KeyInitType GetSetKey(ElementInitType Element)
+	{
+		return Element;
+	}
+
+	static FORCEINLINE bool Matches(KeyInitType A, KeyInitType B)
+	{
+		return A == B;
+	}
+
+	static FORCEINLINE uint32 GetKeyHash(KeyInitType Key)
+	{
+		const uint32 Modifiers = Key.bShift | (Key.bCtrl << 1) | (Key.bAlt << 2) | (Key.bCmd << 3);
+		return HashCombine(HashCombine(GetTypeHash(Key.ActionName), GetTypeHash(Key.Key)), Modifiers);
+	}
+};
+
+/**
+ * TSet key funcs hashing every field compared by FInputAxisKeyMapping::operator==.
+ */
+struct FInputAxisKeyMappingKeyFuncs : BaseKeyFuncs<FInputAxisKeyMapping, FInputAxisKeyMapping>
+{
+	static FORCEINLINE KeyInitType GetSetKey(ElementInitType Element)
+	{
+		return Element;
+	}
+
+	static FORCEINLINE bool Matches(KeyInitType A, KeyInitType B)
+	{
+		return A == B;
+	}
+
+	static FORCEINLINE uint32 GetKeyHash(KeyInitType Key)
+	{
+		//-0 and 0 compare equal, so they have to hash the same
+		const uint32 ScaleHash = Key.Scale == 0.f ? 0u : GetTypeHash(Key.Scale);
+		return HashCombine(HashCombine(GetTypeHash(Key.AxisName), GetTypeHash(Key.Key)), ScaleHash);
+	}
+};
+
+typedef TSet<FInputActionKeyMapping, FInputActionKeyMappingKeyFuncs> FInputActionKeyMappingSet;
+typedef TSet<FInputAxisKeyMapping, FInputAxisKeyMappingKeyFuncs> FInputAxisKeyMappingSet;
+
+/**
+ * Tracks which mapping arrays a config section defines while its entries are applied.
+ */
+struct FInputMappingsParseState
+{
+	bool bDefinesActions = false;
+	bool bDefinesAxis = false;
+
+	// A plain entry replaces what the lower layers had, the first time the array shows up
+	bool bReplacedActions = false;
+	bool bReplacedAxis = false;
+};
+
+/**
+ * Mappings to remove and to add to turn one set of bindings into another.
+ */
+struct FInputBindingsDiff
+{
+	TArray<FInputActionKeyMapping> ActionsToRemove;
+	TArray<FInputActionKeyMapping> ActionsToAdd;
+	TArray<FInputAxisKeyMapping> AxisToRemove;
+	TArray<FInputAxisKeyMapping> AxisToAdd;
+
+	int32 Num() const
+	{
+		return ActionsToRemove.Num() + ActionsToAdd.Num() + AxisToRemove.Num() + AxisToAdd.Num();
+	}
+};
+
 /**
  * 
  */
@@ -142,8 +249,79 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Key Bindings")
 	static bool RemoveActionBinding(FInputAction BindingToRemove);
 
+	UFUNCTION(BlueprintPure, Category = "Key Bindings")
+	static void ExportBindings(FInputBindingsProfile& Profile);
+
+	/**
+	 * Validates, dedupes and commits a whole profile with a single save and rebuild.
+	 * Nothing is changed if any entry has an empty name or an invalid key.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Key Bindings")
+	static bool ImportBindings(const FInputBindingsProfile& Profile, EBindingImportPolicy Policy);
+
+	/** Writes all current bindings to FilePath as JSON */
+	UFUNCTION(BlueprintCallable, Category = "Key Bindings")
+	static bool ExportBindingsToFile(const FString& FilePath);
+
+	/** Reads a JSON profile written by ExportBindingsToFile and imports it */
+	UFUNCTION(BlueprintCallable, Category = "Key Bindings")
+	static bool ImportBindingsFromFile(const FString& FilePath, EBindingImportPolicy Policy);
+
+	/**
+	 * Starts polling the saved Input.ini (or FilePath, if given) and applies external edits
+	 * to the live bindings. The file is parsed off the game thread.
+	 * Returns false if the default bindings the file is layered on cannot be read.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Key Bindings")
+	static bool StartWatchingInputConfig(const FString& FilePath, float PollInterval = 1.f);
+
+	UFUNCTION(BlueprintCallable, Category = "Key Bindings")
+	static void StopWatchingInputConfig();
+
+	/**
+	 * Parses one ActionMappings/AxisMappings entry of the [/Script/Engine.InputSettings] section.
+	 * OutOperator is its +, ., - or ! prefix, or 0 for a plain entry; ! entries carry no mapping.
+	 * Returns false if the line is not a mapping entry or cannot be parsed.
+	 */
+	static bool ParseInputSettingsEntry(const FString& Line, TCHAR& OutOperator, bool& bOutIsAction, FInputActionKeyMapping& OutAction, FInputAxisKeyMapping& OutAxis);
+
+	/**
+	 * Applies one entry of the input settings section on top of the mappings of the lower config layers,
+	 * the way the config system combines them. Returns false if the line is not a mapping entry.
+	 */
+	static bool ParseInputSettingsLine(const FString& Line, TArray<FInputActionKeyMapping>& Actions, TArray<FInputAxisKeyMapping>& Axis, FInputMappingsParseState& State);
+
+	/**
+	 * Applies the [/Script/Engine.InputSettings] section of a config file on top of the given mappings.
+	 * Returns false if the section is not there.
+	 */
+	static bool ParseInputSettingsSection(const TArray<FString>& Lines, TArray<FInputActionKeyMapping>& Actions, TArray<FInputAxisKeyMapping>& Axis, FInputMappingsParseState& State);
+
+	/**
+	 * Collects the mappings of the config layers below the saved Input.ini: the engine BaseInput.ini
+	 * and the project DefaultInput.ini (or DefaultInputPath, if given).
+	 */
+	static bool LoadDefaultInputBindings(const FString& DefaultInputPath, TArray<FInputActionKeyMapping>& OutActions, TArray<FInputAxisKeyMapping>& OutAxis);
+
+	/** Formats a mapping as the value of an ActionMappings entry, as read back by ParseInputSettingsEntry */
+	static FString ExportInputSettingsValue(const FInputActionKeyMapping& Mapping);
+
+	/** Formats a mapping as the value of an AxisMappings entry, as read back by ParseInputSettingsEntry */
+	static FString ExportInputSettingsValue(const FInputAxisKeyMapping& Mapping);
+
+	static void DiffBindings(const TArray<FInputActionKeyMapping>& CurrentActions, const TArray<FInputAxisKeyMapping>& CurrentAxis,
+		const TArray<FInputActionKeyMapping>& DesiredActions, const TArray<FInputAxisKeyMapping>& DesiredAxis, FInputBindingsDiff& OutDiff);
+
+	/**
+	 * Applies only the changed mappings to the input settings and to every player,
+	 * instead of restoring all defaults. Saves to disk only if asked to.
+	 */
+	static bool ApplyBindingsDiff(const FInputBindingsDiff& Diff, bool bSaveToDisk);
+
 private:
 	static void UpdateAxisBinding(const FInputAxis& SrcInputAxis, FInputAxisKeyMapping& DstInputAxis);
 
 	static void UpdateActionBinding(const FInputAction& SrcInputAction, FInputActionKeyMapping& DstInputAction);
+
+	static void SaveAndRebuildKeyMappings(class UInputSettings* Settings);
 };